@@ -4,7 +4,11 @@
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
+#include <cstdlib>
 #include <chrono>
+#include <atomic>
+#include <fstream>
+#include <new>
 
 #include "pubsub.h"
 
@@ -17,6 +21,77 @@
     #include <psapi.h>
 #endif
 
+// ========== Memory Metrics ==========
+namespace alloc_stats {
+    std::atomic<uint64_t> count{0}; ///< Calls to global operator new since start.
+    std::atomic<uint64_t> bytes{0}; ///< Bytes requested from global operator new since start.
+
+    void record(std::size_t size) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void* operator new(std::size_t size) {
+    alloc_stats::record(size);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    alloc_stats::record(size);
+    auto alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+    void* p = _aligned_malloc(size ? size : 1, alignment);
+#else
+    void* p = std::aligned_alloc(alignment, (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment);
+#endif
+    if (p) return p;
+    throw std::bad_alloc();
+}
+
+// GCC pairs these replacements with the standard operator new and flags the free() calls.
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+#ifdef _WIN32
+void operator delete(void* p, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { _aligned_free(p); }
+#else
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+// Resident set size of this process, 0 where unsupported.
+std::size_t current_rss_bytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.WorkingSetSize;
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+void report_memory(benchmark::State& state, const pubsub::Publisher& pub) {
+    state.counters["rss_mb"] = static_cast<double>(current_rss_bytes()) / (1024.0 * 1024.0);
+    state.counters["pub_bytes"] = static_cast<double>(pub.memory_usage().total());
+}
+
 // ========== Event Definition ==========
 constexpr auto MyEvent = pubsub::Event<void(int)>();
 
@@ -39,18 +114,32 @@ std::unique_ptr<pubsub::Publisher> create_publisher_with_heavy_subs(int num_subs
     return pub;
 }
 
+// ========== Create Publisher with N Trivial Subscribers ==========
+std::unique_ptr<pubsub::Publisher> create_publisher_with_light_subs(int num_subs) {
+    auto pub = std::make_unique<pubsub::Publisher>();
+    for (int i = 0; i < num_subs; ++i) {
+        pub->subscribe<MyEvent>([](int x) {
+            benchmark::DoNotOptimize(x);
+        });
+    }
+    return pub;
+}
+
 // ========== Global Unordered Map of Prebuilt Publishers ==========
 std::vector<int> subscriber_counts = {1, 10, 100, 500, 1000};
 std::unordered_map<int, std::unique_ptr<pubsub::Publisher>> heavy_publishers;
+std::unordered_map<int, std::unique_ptr<pubsub::Publisher>> light_publishers;
 
 // ========== Updated Benchmark Macro with Memory + Time Metrics ==========
-#define DEFINE_HEAVY_EMIT_BENCH(name, emit_method)                                                                  \
+#define DEFINE_EMIT_BENCH(name, publishers, emit_method)                                                            \
     static void name(benchmark::State& state) {                                                                     \
         std::unordered_map<int, std::unique_ptr<pubsub::Publisher>>::iterator it;                                   \
         int subs = state.range(0);                                                                                  \
-        it = heavy_publishers.find(subs);                                                                           \
-        if (it == heavy_publishers.end()) state.SkipWithError("Missing pub");                                       \
+        it = publishers.find(subs);                                                                                 \
+        if (it == publishers.end()) state.SkipWithError("Missing pub");                                             \
         auto& pub = it->second;                                                                                     \
+        uint64_t allocs_before = alloc_stats::count.load(std::memory_order_relaxed);                                \
+        uint64_t bytes_before = alloc_stats::bytes.load(std::memory_order_relaxed);                                 \
         for (auto _ : state) {                                                                                      \
             auto start_time = std::chrono::high_resolution_clock::now();                                            \
             benchmark::DoNotOptimize(pub->emit_method);                                                             \
@@ -61,6 +150,16 @@ std::unordered_map<int, std::unique_ptr<pubsub::Publisher>> heavy_publishers;
             state.counters["subs_per_sec"] =                                                                        \
                 benchmark::Counter(subs, benchmark::Counter::kIsRate);                                              \
         }                                                                                                           \
+        auto iterations = static_cast<double>(std::max<benchmark::IterationCount>(state.iterations(), 1));          \
+        state.counters["allocs_per_emit"] =                                                                         \
+            (alloc_stats::count.load(std::memory_order_relaxed) - allocs_before) / iterations;                      \
+        state.counters["alloc_bytes_per_emit"] =                                                                    \
+            (alloc_stats::bytes.load(std::memory_order_relaxed) - bytes_before) / iterations;                       \
+        report_memory(state, *pub);                                                                                 \
+        if (auto plan = pub->dispatch_plan<MyEvent>(); plan.cost.count() > 0) {                                     \
+            state.counters["auto_mode"] = static_cast<double>(plan.mode);                                           \
+            state.counters["auto_chunks"] = static_cast<double>(plan.chunks);                                       \
+        }                                                                                                           \
         state.SetComplexityN(state.range(0));                                                                       \
     }                                                                                                               \
     BENCHMARK(name)->MeasureProcessCPUTime()                                                                        \
@@ -70,6 +169,9 @@ std::unordered_map<int, std::unique_ptr<pubsub::Publisher>> heavy_publishers;
                    ->Complexity(benchmark::oN)                                                                      \
     ;
 
+#define DEFINE_HEAVY_EMIT_BENCH(name, emit_method) DEFINE_EMIT_BENCH(name, heavy_publishers, emit_method)
+#define DEFINE_LIGHT_EMIT_BENCH(name, emit_method) DEFINE_EMIT_BENCH(name, light_publishers, emit_method)
+
 // ========== Emit Variants ==========
 DEFINE_HEAVY_EMIT_BENCH(BM_PubSub_Emit_Sync, emit<MyEvent>(42))
 
@@ -86,10 +188,52 @@ DEFINE_HEAVY_EMIT_BENCH(BM_PubSub_Emit_StdExec_unseq, emit_async<MyEvent>(std::e
 DEFINE_HEAVY_EMIT_BENCH(BM_PubSub_Emit_TBB, emit_tbb_async<MyEvent>(42))
 #endif
 
+DEFINE_HEAVY_EMIT_BENCH(BM_PubSub_Emit_Auto, emit_auto<MyEvent>(42))
+
+// ========== Cheap Subscribers: Adaptive vs. Fixed Strategies ==========
+DEFINE_LIGHT_EMIT_BENCH(BM_PubSub_Light_Emit_Sync, emit<MyEvent>(42))
+
+#if defined(__cpp_lib_execution)
+DEFINE_LIGHT_EMIT_BENCH(BM_PubSub_Light_Emit_StdExec_par, emit_async<MyEvent>(std::execution::par, 42))
+#endif
+
+#ifdef WITH_TBB
+DEFINE_LIGHT_EMIT_BENCH(BM_PubSub_Light_Emit_TBB, emit_tbb_async<MyEvent>(42))
+#endif
+
+DEFINE_LIGHT_EMIT_BENCH(BM_PubSub_Light_Emit_Auto, emit_auto<MyEvent>(42))
+
+// ========== Subscription Churn: Footprint With and Without Compaction ==========
+struct ChurnSubscriber {
+    void on_event(int x) { benchmark::DoNotOptimize(x); }
+};
+
+static void BM_PubSub_Churn(benchmark::State& state) {
+    auto subs = static_cast<std::size_t>(state.range(0));
+    bool compact = state.range(1) != 0;
+    pubsub::Publisher pub;
+    ChurnSubscriber keeper;
+    auto keeper_token = pub.subscribe<MyEvent>(&keeper, &ChurnSubscriber::on_event);
+    for (auto _ : state) {
+        std::vector<ChurnSubscriber> crowd(subs);
+        std::vector<pubsub::SubscriptionToken> tokens;
+        tokens.reserve(subs);
+        for (auto& sub : crowd) {
+            tokens.push_back(pub.subscribe<MyEvent>(&sub, &ChurnSubscriber::on_event));
+        }
+        state.counters["peak_pub_bytes"] = static_cast<double>(pub.memory_usage().total());
+        tokens.clear();
+        if (compact) pub.compact();
+    }
+    report_memory(state, pub);
+}
+BENCHMARK(BM_PubSub_Churn)->Args({1000, 0})->Args({1000, 1})->Args({100000, 0})->Args({100000, 1});
+
 // ========== Manual Main ==========
 int main(int argc, char** argv) {
     for (int count : subscriber_counts) {
         heavy_publishers[count] = create_publisher_with_heavy_subs(count);
+        light_publishers[count] = create_publisher_with_light_subs(count);
     }
 
     benchmark::Initialize(&argc, argv);
@@ -11,12 +11,20 @@
 #include <future>
 #include <execution>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <span>
+#include <vector>
+#include <utility>
+#include <cstdint>
 
 #ifdef WITH_TBB
     #include <tbb/parallel_for_each.h>
 #endif
 
 #include "unique_couter.h"
+#include "strand.h"
 
 /**
  * @file pubsub.hpp
@@ -54,11 +62,255 @@ namespace pubsub {
         { EventT::id } -> std::convertible_to<size_t>;
     };
 
+    namespace detail {
+
+        /**
+         * @brief Splits an event's handler signature into its callable part and its noexcept flag.
+         */
+        template<typename HandlerT>
+        struct signature;
+
+        template<typename R, typename... Params>
+        struct signature<R(Params...)> {
+            using type = R(Params...);
+            static constexpr bool is_noexcept = false;
+        };
+
+        template<typename R, typename... Params>
+        struct signature<R(Params...) noexcept> {
+            using type = R(Params...);
+            static constexpr bool is_noexcept = true;
+        };
+
+        /**
+         * @brief Padding unit used to keep per-worker emit state on separate cache lines.
+         */
+        inline constexpr size_t cache_line_size = 64;
+
+        /**
+         * @brief Hardware concurrency, queried once since the query can hit the filesystem.
+         */
+        inline size_t hardware_workers() {
+            static const size_t workers = std::max(1u, std::thread::hardware_concurrency());
+            return workers;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Callback type stored for an event, i.e. its handler signature without `noexcept`.
+     */
+    template<auto Event>
+    using callback_t = std::function<typename detail::signature<typename decltype(Event)::func_t>::type>;
+
+    /**
+     * @brief What an emit does once a callback has thrown.
+     */
+    enum class ErrorPolicy {
+        Continue, ///< Call every callback and report all failures.
+        Stop,     ///< Start no further callbacks; callbacks already running in parallel finish.
+        Rethrow   ///< Like Stop, then rethrow the first captured exception from the emit call.
+    };
+
+    /**
+     * @brief Outcome of an emit.
+     */
+    struct EmitReport {
+        /// Subscribers whose callback threw, in subscription order: the object for
+        /// member-function subscriptions, SubscriptionToken::handle() for free functions and lambdas.
+        std::vector<const void*> failed;
+        std::exception_ptr first_error; ///< Exception of the first failed subscriber, if any.
+
+        /**
+         * @brief Whether every called subscriber returned normally.
+         */
+        bool ok() const {
+            return failed.empty();
+        }
+
+        explicit operator bool() const {
+            return ok();
+        }
+    };
+
+    /**
+     * @brief How an adaptive emit dispatches the callbacks.
+     */
+    enum class Dispatch {
+        Sequential, ///< In the emitting thread.
+        Chunked,    ///< In parallel, over contiguous ranges sized to the configured grain.
+        TBB         ///< In parallel with oneTBB work stealing, for callbacks heavier than a grain.
+    };
+
+    /**
+     * @brief Cost thresholds an adaptive emit compares its running estimates against.
+     */
+    struct DispatchThresholds {
+        std::chrono::nanoseconds parallel_work{50'000}; ///< Estimated work per emit from which parallel dispatch pays off.
+        std::chrono::nanoseconds grain{10'000};         ///< Target work per parallel chunk.
+
+        bool operator==(const DispatchThresholds&) const = default;
+    };
+
+    /**
+     * @brief Dispatch an adaptive emit would use right now, with the estimates it is based on.
+     */
+    struct DispatchPlan {
+        Dispatch mode = Dispatch::Sequential;
+        size_t chunks = 1;              ///< Number of ranges the callbacks are split into.
+        size_t fanout = 0;              ///< Number of subscribed callbacks.
+        std::chrono::nanoseconds cost{}; ///< Running estimate of the time spent per callback.
+        DispatchThresholds thresholds;  ///< Thresholds the decision was made with.
+    };
+
+    /**
+     * @brief Estimated heap footprint of one event's handler.
+     * @details Computed from container sizes; state that callbacks allocate
+     * themselves (large lambda captures) is not included.
+     */
+    struct EventMemory {
+        size_t id = 0;             ///< Event ID.
+        size_t subscribers = 0;    ///< Number of subscribed callbacks.
+        size_t callback_bytes = 0; ///< Callback list nodes.
+        size_t index_bytes = 0;    ///< Buckets and nodes of the member-subscription and strand indexes.
+        size_t handler_bytes = 0;  ///< The handler object itself.
+
+        size_t total() const {
+            return callback_bytes + index_bytes + handler_bytes;
+        }
+    };
+
+    /**
+     * @brief Estimated heap footprint of a publisher, broken down per event.
+     */
+    struct MemoryUsage {
+        std::vector<EventMemory> events; ///< One entry per live event handler.
+        size_t registry_bytes = 0;      ///< The publisher's event-to-handler map.
+
+        size_t total() const {
+            size_t bytes = registry_bytes;
+            for (const auto& event : events) bytes += event.total();
+            return bytes;
+        }
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Bytes held by an unordered container: its bucket array plus one node per element.
+         */
+        template<typename Map>
+        size_t hashed_bytes(const Map& map) {
+            return map.bucket_count() * sizeof(void*) + map.size() * (sizeof(typename Map::value_type) + sizeof(void*));
+        }
+
+        /**
+         * @brief Rebuild an unordered container so its bucket array fits its current size.
+         */
+        template<typename Map>
+        void shrink_to_fit(Map& map) {
+            Map(map.begin(), map.end()).swap(map);
+        }
+
+        /**
+         * @brief Whether an unordered container keeps far more buckets than it needs.
+         */
+        template<typename Map>
+        bool oversized(const Map& map) {
+            return map.bucket_count() > 64 && map.size() * 4 < map.bucket_count();
+        }
+
+        /**
+         * @brief Failures one worker thread recorded during one parallel emit.
+         */
+        struct alignas(cache_line_size) FailureSlot {
+            std::vector<std::pair<uint64_t, const void*>> failed; ///< Serial and handle of each failed subscription.
+            std::exception_ptr first_error;                       ///< Exception of the lowest-serial failure.
+            uint64_t error_serial = 0;
+            FailureSlot* next = nullptr;
+
+            void record(uint64_t serial, const void* owner, std::exception_ptr error) {
+                failed.emplace_back(serial, owner);
+                if (!first_error || serial < error_serial) {
+                    first_error = std::move(error);
+                    error_serial = serial;
+                }
+            }
+        };
+
+        /**
+         * @brief Per-worker failure slots of one parallel emit.
+         * @details A worker claims its own slot on its first failure, with a
+         * single CAS, and records into it without sharing anything afterwards;
+         * workers without failures touch nothing. Works with any executor, as
+         * slots are found through a thread-local cache instead of a worker index.
+         */
+        class FailureSlots {
+            struct Cached {
+                uint64_t emit = 0;
+                FailureSlot* slot = nullptr;
+            };
+
+            std::atomic<FailureSlot*> head{nullptr};
+            const uint64_t emit;
+
+            static uint64_t next_emit() {
+                static std::atomic<uint64_t> emits{0};
+                return emits.fetch_add(1, std::memory_order_relaxed) + 1;
+            }
+
+            static Cached& cached() {
+                thread_local Cached last;
+                return last;
+            }
+
+        public:
+            FailureSlots() : emit(next_emit()) {}
+
+            ~FailureSlots() {
+                for (FailureSlot* slot = head.load(std::memory_order_relaxed); slot;) {
+                    delete std::exchange(slot, slot->next);
+                }
+            }
+
+            FailureSlots(const FailureSlots&) = delete;
+            FailureSlots& operator=(const FailureSlots&) = delete;
+
+            /**
+             * @brief Slot of the calling thread, claimed on first use.
+             */
+            FailureSlot& local() {
+                auto& last = cached();
+                if (last.emit != emit) {
+                    auto* slot = new FailureSlot{};
+                    slot->next = head.load(std::memory_order_relaxed);
+                    while (!head.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {}
+                    last = Cached{emit, slot};
+                }
+                return *last.slot;
+            }
+
+            /**
+             * @brief Claimed slots; only valid once every worker has finished.
+             */
+            const FailureSlot* first() const {
+                return head.load(std::memory_order_acquire);
+            }
+        };
+
+    } // namespace detail
+
+    struct IEventHandler;
+
     /**
      * @brief RAII token used to automatically unsubscribe when destroyed.
+     * @details Unsubscribes like Publisher::unsubscribe, including for strand-bound objects.
      */
     class SubscriptionToken {
-        std::function<void()> unsubscribe_fn; ///< Internal function to unsubscribe.
+        std::function<void()> unsubscribe_fn;       ///< Internal function to unsubscribe.
+        const void* id = nullptr;                   ///< Handle of the subscription in emit reports.
+        std::weak_ptr<const IEventHandler> source;  ///< Handler holding the subscription, if tracked.
+        uint64_t serial = 0;                        ///< Subscription this token belongs to, 0 if untracked.
 
     public:
         SubscriptionToken() = default;
@@ -69,6 +321,24 @@ namespace pubsub {
          */
         explicit SubscriptionToken(std::function<void()> fn) : unsubscribe_fn(std::move(fn)) {}
 
+        /**
+         * @brief Construct with unsubscription logic and the subscription's handle.
+         * @param fn Function to call when token is destroyed, may be empty.
+         * @param handle Value identifying the subscription in EmitReport::failed.
+         */
+        SubscriptionToken(std::function<void()> fn, const void* handle) : unsubscribe_fn(std::move(fn)), id(handle) {}
+
+        /**
+         * @brief Construct a token tied to one subscription of a handler.
+         * @param fn Function to call when token is destroyed.
+         * @param handle Value identifying the subscription in EmitReport::failed.
+         * @param handler Handler holding the subscription.
+         * @param subscription Serial of the subscription within the handler.
+         */
+        SubscriptionToken(std::function<void()> fn, const void* handle,
+                          std::weak_ptr<const IEventHandler> handler, uint64_t subscription)
+            : unsubscribe_fn(std::move(fn)), id(handle), source(std::move(handler)), serial(subscription) {}
+
         /**
          * @brief Destructor automatically calls the unsubscription function.
          */
@@ -76,13 +346,36 @@ namespace pubsub {
             if (unsubscribe_fn) unsubscribe_fn();
         }
 
+        /**
+         * @brief Whether the token unsubscribes anything on destruction.
+         */
+        explicit operator bool() const {
+            return static_cast<bool>(unsubscribe_fn);
+        }
+
+        /**
+         * @brief Handle the subscription is reported under in EmitReport::failed.
+         */
+        const void* handle() const {
+            return id;
+        }
+
+        /**
+         * @brief Whether the subscription of the token still exists.
+         * @details False once it was unsubscribed some other way, e.g. through
+         * Publisher::unsubscribe; destroying such a token does nothing.
+         */
+        bool active() const;
+
         SubscriptionToken(const SubscriptionToken&) = delete;
         SubscriptionToken& operator=(const SubscriptionToken&) = delete;
 
         /**
          * @brief Move constructor.
          */
-        SubscriptionToken(SubscriptionToken&& other) noexcept : unsubscribe_fn(std::move(other.unsubscribe_fn)) {
+        SubscriptionToken(SubscriptionToken&& other) noexcept
+            : unsubscribe_fn(std::move(other.unsubscribe_fn)), id(std::exchange(other.id, nullptr)),
+              source(std::move(other.source)), serial(std::exchange(other.serial, 0)) {
             other.unsubscribe_fn = nullptr;
         }
 
@@ -93,6 +386,9 @@ namespace pubsub {
             if (this != &other) {
                 unsubscribe_fn = std::move(other.unsubscribe_fn);
                 other.unsubscribe_fn = nullptr;
+                id = std::exchange(other.id, nullptr);
+                source = std::move(other.source);
+                serial = std::exchange(other.serial, 0);
             }
             return *this;
         }
@@ -103,46 +399,354 @@ namespace pubsub {
      */
     struct IEventHandler {
         virtual ~IEventHandler() = default;
+
+        /**
+         * @brief Whether the handler holds no subscriptions and no custom configuration.
+         */
+        virtual bool empty() const = 0;
+
+        /**
+         * @brief Release storage kept for subscriptions that are gone.
+         */
+        virtual void compact() = 0;
+
+        /**
+         * @brief Estimated heap footprint of the handler.
+         */
+        virtual EventMemory memory_usage() const = 0;
+
+        /**
+         * @brief Whether a given subscription of an object is still registered.
+         */
+        virtual bool subscribed(const void* owner, uint64_t serial) const = 0;
     };
 
+    inline bool SubscriptionToken::active() const {
+        if (!unsubscribe_fn) return false;
+        if (serial == 0) return true; // Not tied to a tracked subscription.
+        auto handler = source.lock();
+        return handler && handler->subscribed(id, serial);
+    }
+
     /**
      * @brief Type-safe handler list for a given event.
      * @tparam Event Event descriptor.
      */
     template<auto Event>
     class EventHandler : public IEventHandler {
-        using function_type = std::function<typename decltype(Event)::func_t>;
-        std::list<function_type> callbacks;
-        std::unordered_map<void*, typename std::list<function_type>::iterator> ptrs;
+        using signature_type = typename detail::signature<typename decltype(Event)::func_t>::type;
+        using function_type = callback_t<Event>;
+
+        /**
+         * @brief A callback with the handle it is reported under.
+         */
+        struct Subscription {
+            const void* owner; ///< Subscribed object, or this entry for free functions and lambdas.
+            function_type fn;
+            uint64_t serial = 0; ///< Increases in subscription order; tells successive subscriptions of an object apart.
+        };
+
+        using const_iterator = typename std::list<Subscription>::const_iterator;
+
+        /// Callbacks of noexcept events are called without any exception handling.
+        static constexpr bool nothrow = detail::signature<typename decltype(Event)::func_t>::is_noexcept;
+
+        std::list<Subscription> callbacks;
+        std::unordered_map<void*, typename std::list<Subscription>::iterator> ptrs;
+        std::unordered_map<void*, detail::StrandBinding> strands; ///< Strands of strand-bound member subscriptions.
+        uint64_t last_serial = 0;                  ///< Serial of the latest subscription.
+
+        /**
+         * @brief Callback range handled by one worker, with its own cache-line-padded outcome.
+         */
+        struct alignas(detail::cache_line_size) Chunk {
+            const_iterator first, last;
+            std::vector<const void*> failed;         ///< Handles of the callbacks of this range that threw.
+            std::exception_ptr first_error;          ///< First exception thrown in this range.
+            std::chrono::nanoseconds elapsed{};       ///< Time spent in this range, measured by adaptive emits.
+        };
+
+        DispatchThresholds thresholds;          ///< Decision thresholds of emit_auto.
+        std::atomic<double> cost_estimate{0.0}; ///< Moving average of nanoseconds per callback.
+
+        /**
+         * @brief Number of chunks a parallel emit splits the callbacks into.
+         */
+        size_t parallel_chunks(size_t workers = detail::hardware_workers()) const {
+            return std::min(callbacks.size(), 4 * workers);
+        }
+
+        /**
+         * @brief Split the callbacks into `count` contiguous ranges of near-equal size.
+         */
+        std::vector<Chunk> split(size_t count) const {
+            std::vector<Chunk> chunks(count);
+            size_t base = count ? callbacks.size() / count : 0;
+            size_t extra = count ? callbacks.size() % count : 0;
+            auto it = callbacks.cbegin();
+            for (size_t i = 0; i < count; ++i) {
+                chunks[i].first = it;
+                std::advance(it, base + (i < extra ? 1 : 0));
+                chunks[i].last = it;
+            }
+            return chunks;
+        }
+
+        /**
+         * @brief Call the callbacks of one chunk, recording failures in the chunk only.
+         */
+        template<ErrorPolicy OnError, typename... Args>
+        static void run(Chunk& chunk, std::atomic<bool>& stop, Args&... args) {
+            for (auto it = chunk.first; it != chunk.last; ++it) {
+                if constexpr (nothrow) {
+                    it->fn(args...);
+                }
+                else {
+                    if constexpr (OnError != ErrorPolicy::Continue) {
+                        if (stop.load(std::memory_order_relaxed)) return;
+                    }
+                    try {
+                        it->fn(args...);
+                    }
+                    catch(...) {
+                        if (!chunk.first_error) chunk.first_error = std::current_exception();
+                        chunk.failed.push_back(it->owner);
+                        if constexpr (OnError != ErrorPolicy::Continue) {
+                            stop.store(true, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Call one callback of a parallel emit, recording a failure in the worker's slot.
+         */
+        template<ErrorPolicy OnError, typename... Args>
+        static void call(const Subscription& cb, std::atomic<bool>& stop, detail::FailureSlots& slots, Args&... args) {
+            if constexpr (OnError != ErrorPolicy::Continue) {
+                if (stop.load(std::memory_order_relaxed)) return;
+            }
+            try {
+                cb.fn(args...);
+            }
+            catch(...) {
+                slots.local().record(cb.serial, cb.owner, std::current_exception());
+                if constexpr (OnError != ErrorPolicy::Continue) {
+                    stop.store(true, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Like run(), additionally recording the time spent in the chunk.
+         */
+        template<ErrorPolicy OnError, typename... Args>
+        static void run_timed(Chunk& chunk, std::atomic<bool>& stop, Args&... args) {
+            auto start = std::chrono::steady_clock::now();
+            run<OnError>(chunk, stop, args...);
+            chunk.elapsed = std::chrono::steady_clock::now() - start;
+        }
+
+        /**
+         * @brief Fold the time measured by an adaptive emit into the per-callback cost estimate.
+         */
+        void observe(std::span<const Chunk> chunks, size_t fanout) {
+            if (fanout == 0) return;
+            std::chrono::nanoseconds total{};
+            for (const auto& chunk : chunks) total += chunk.elapsed;
+            double sample = static_cast<double>(total.count()) / static_cast<double>(fanout);
+            double previous = cost_estimate.load(std::memory_order_relaxed);
+            while (!cost_estimate.compare_exchange_weak(previous,
+                       previous == 0.0 ? sample : previous + (sample - previous) / 8.0, std::memory_order_relaxed)) {}
+        }
+
+        /**
+         * @brief Merge per-chunk outcomes, in subscription order, into a report.
+         */
+        template<ErrorPolicy OnError>
+        EmitReport merge(std::span<Chunk> chunks) const {
+            EmitReport report;
+            for (auto& chunk : chunks) {
+                if (chunk.failed.empty()) continue;
+                if (!report.first_error) report.first_error = chunk.first_error;
+                report.failed.insert(report.failed.end(), chunk.failed.begin(), chunk.failed.end());
+            }
+            if constexpr (OnError == ErrorPolicy::Rethrow) {
+                if (report.first_error) std::rethrow_exception(report.first_error);
+            }
+            return report;
+        }
+
+        /**
+         * @brief Merge per-worker failure slots, sorted into subscription order, into a report.
+         */
+        template<ErrorPolicy OnError>
+        EmitReport merge(const detail::FailureSlots& slots) const {
+            EmitReport report;
+            const detail::FailureSlot* first = slots.first();
+            if (!first) return report;
+            std::vector<std::pair<uint64_t, const void*>> failed;
+            uint64_t error_serial = 0;
+            for (const auto* slot = first; slot; slot = slot->next) {
+                failed.insert(failed.end(), slot->failed.begin(), slot->failed.end());
+                if (!report.first_error || slot->error_serial < error_serial) {
+                    report.first_error = slot->first_error;
+                    error_serial = slot->error_serial;
+                }
+            }
+            std::sort(failed.begin(), failed.end());
+            report.failed.reserve(failed.size());
+            for (const auto& [serial, owner] : failed) report.failed.push_back(owner);
+            if constexpr (OnError == ErrorPolicy::Rethrow) {
+                std::rethrow_exception(report.first_error);
+            }
+            return report;
+        }
 
     public:
+        EventHandler() = default;
+
+        /**
+         * @brief Stops the calls of strand-bound objects, which may be destroyed
+         * as soon as the handler is gone; see unsubscribe().
+         */
+        ~EventHandler() override {
+            for (auto& [obj, binding] : strands) {
+                binding.release();
+            }
+        }
+
         /**
          * @brief Add a free-function/lambda callback.
+         * @return Handle the callback is reported under in EmitReport::failed.
+         */
+        const void* subscribe(const function_type& f) {
+            auto& entry = callbacks.emplace_back(Subscription{nullptr, f, ++last_serial});
+            return entry.owner = &entry;
+        }
+
+        /**
+         * @brief Add a free-function/lambda callback whose calls are posted to a strand.
          */
-        void subscribe(const function_type& f) {
-            callbacks.push_back(f);
+        const void* subscribe(const function_type& f, const Strand& strand) {
+            auto& entry = callbacks.emplace_back(Subscription{nullptr, detail::strand_binder<signature_type>::bind(f, strand), ++last_serial});
+            return entry.owner = &entry;
         }
 
         /**
          * @brief Add a member function callback from an object.
+         * @return False if the object was already subscribed.
+         */
+        template<typename C, typename... Args>
+        bool subscribe(C* obj, void (C::* mem_fn_ptr)(Args...)) {
+            if (ptrs.contains(obj)) return false;
+            function_type f = [obj, mem_fn_ptr](Args... args) noexcept(nothrow) {
+                ((*obj).*mem_fn_ptr)(args...);
+            };
+            ptrs[obj] = callbacks.insert(callbacks.end(), Subscription{obj, std::move(f), ++last_serial});
+            return true;
+        }
+
+        /**
+         * @brief Add a member function callback whose calls are posted to a strand.
+         * @return False if the object was already subscribed.
          */
         template<typename C, typename... Args>
-        void subscribe(C* obj, void (C::* mem_fn_ptr)(Args...)) {
-            if (ptrs.contains(obj)) return;
-            function_type f = [obj, mem_fn_ptr](Args... args) noexcept {
+        bool subscribe(C* obj, void (C::* mem_fn_ptr)(Args...), const Strand& strand) {
+            if (ptrs.contains(obj)) return false;
+            function_type f = [obj, mem_fn_ptr](Args... args) noexcept(nothrow) {
                 ((*obj).*mem_fn_ptr)(args...);
             };
-            ptrs[obj] = callbacks.insert(callbacks.end(), f);
+            detail::StrandBinding binding{strand};
+            ptrs[obj] = callbacks.insert(callbacks.end(),
+                Subscription{obj, detail::strand_binder<signature_type>::bind(std::move(f), strand, binding.gate), ++last_serial});
+            strands.insert_or_assign(obj, std::move(binding));
+            return true;
         }
 
         /**
          * @brief Unsubscribe a previously subscribed object.
+         * @details For strand-bound objects this waits until the calls already
+         * queued on the strand have run, so the object may be destroyed afterwards.
+         * Called from a ThreadPool worker, it skips the queued calls instead and
+         * only waits for one that is running elsewhere, so it never blocks on the pool.
+         * Index storage is shrunk once it is mostly empty.
          */
         template<typename C>
         void unsubscribe(C* obj) {
+            unsubscribe(obj, 0);
+        }
+
+        /**
+         * @brief Unsubscribe an object only if its current subscription has the given serial.
+         * @param serial Serial of the subscription, or 0 for whichever is current.
+         */
+        template<typename C>
+        void unsubscribe(C* obj, uint64_t serial) {
+            if (serial != 0 && !subscribed(obj, serial)) return;
             if (ptrs.contains(obj)) {
                 callbacks.erase(ptrs[obj]);
                 ptrs.erase(obj);
+                if (detail::oversized(ptrs)) detail::shrink_to_fit(ptrs);
+            }
+            if (auto it = strands.find(obj); it != strands.end()) {
+                detail::StrandBinding binding = std::move(it->second);
+                strands.erase(it);
+                if (detail::oversized(strands)) detail::shrink_to_fit(strands);
+                binding.release();
+            }
+        }
+
+        bool empty() const override {
+            return callbacks.empty() && strands.empty() && thresholds == DispatchThresholds{};
+        }
+
+        /**
+         * @brief Serial of an object's current subscription, or 0 if it is not subscribed.
+         */
+        uint64_t serial_of(const void* owner) const {
+            auto it = ptrs.find(const_cast<void*>(owner));
+            return it == ptrs.end() ? 0 : it->second->serial;
+        }
+
+        bool subscribed(const void* owner, uint64_t serial) const override {
+            return serial != 0 && serial_of(owner) == serial;
+        }
+
+        void compact() override {
+            detail::shrink_to_fit(ptrs);
+            detail::shrink_to_fit(strands);
+        }
+
+        EventMemory memory_usage() const override {
+            EventMemory usage;
+            usage.id = decltype(Event)::id;
+            usage.subscribers = callbacks.size();
+            usage.callback_bytes = callbacks.size() * (sizeof(Subscription) + 2 * sizeof(void*));
+            usage.index_bytes = detail::hashed_bytes(ptrs) + detail::hashed_bytes(strands);
+            usage.handler_bytes = sizeof(*this);
+            return usage;
+        }
+
+        /**
+         * @brief Emit an event synchronously and report failed subscribers.
+         */
+        template<ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args>
+        EmitReport emit_report(Args... args) {
+            if constexpr (nothrow) {
+                for (const auto& cb : callbacks) {
+                    cb.fn(args...);
+                }
+                return {};
+            }
+            else {
+                std::atomic<bool> stop{false};
+                Chunk all;
+                all.first = callbacks.cbegin();
+                all.last = callbacks.cend();
+                run<OnError>(all, stop, args...);
+                return merge<OnError>(std::span(&all, 1));
             }
         }
 
@@ -151,115 +755,335 @@ namespace pubsub {
          */
         template<typename... Args>
         [[nodiscard]] bool emit(Args... args) {
-            bool success = true;
-            for (const auto& cb : callbacks) {
-                try {
-                    cb(args...);
-                }
-                catch(...) {
-                    success = false;
-                }  
-            }
-            return success;
+            return emit_report(args...).ok();
         }
 
         /**
-         * @brief Emit an event asynchronously.
+         * @brief Emit an event on one `std::async` thread per callback and report failed subscribers.
+         * @details Exceptions travel through the futures and are collected by the calling thread.
          * @todo Implement and use thread pool with coroutine 
          * that takes the callbacks and their arguments from 
          * a queue and calls them when a thread in the pool is free
          */
-        template<typename... Args>
-        [[nodiscard]] bool emit_thread_async(Args... args) {
-            bool success = true;
+        template<ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args>
+        EmitReport emit_thread_async_report(Args... args) {
+            std::atomic<bool> stop{false};
             std::vector<std::future<void>> futures;
             futures.reserve(callbacks.size());
             for (const auto& cb : callbacks) {
-                futures.emplace_back(std::async(std::launch::async, cb, args...));
+                futures.emplace_back(std::async(std::launch::async, [&stop, cb = cb.fn, args...]() {
+                    if constexpr (nothrow || OnError == ErrorPolicy::Continue) {
+                        cb(args...);
+                    }
+                    else {
+                        if (stop.load(std::memory_order_relaxed)) return;
+                        try {
+                            cb(args...);
+                        }
+                        catch(...) {
+                            stop.store(true, std::memory_order_relaxed);
+                            throw;
+                        }
+                    }
+                }));
+            }
+            if constexpr (nothrow) {
+                for (auto& future : futures) future.wait();
+                return {};
+            }
+            else {
+                Chunk all;
+                auto cb = callbacks.cbegin();
+                for (auto& future : futures) {
+                    try {
+                        future.get();
+                    }
+                    catch(...) {
+                        if (!all.first_error) all.first_error = std::current_exception();
+                        all.failed.push_back(cb->owner);
+                    }
+                    ++cb;
+                }
+                return merge<OnError>(std::span(&all, 1));
             }
-            return success;
+        }
+
+        /**
+         * @brief Emit an event asynchronously.
+         */
+        template<typename... Args>
+        [[nodiscard]] bool emit_thread_async(Args... args) {
+            return emit_thread_async_report(args...).ok();
         }
 
 #ifdef WITH_TBB
+        /**
+         * @brief Emit an event asynchronously using oneTBB and report failed subscribers.
+         */
+        template<ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args>
+        EmitReport emit_tbb_async_report(Args... args) {
+            if constexpr (nothrow) {
+                tbb::parallel_for_each(callbacks.begin(), callbacks.end(), [&](const auto& cb) {
+                    cb.fn(args...);
+                });
+                return {};
+            }
+            else {
+                std::atomic<bool> stop{false};
+                detail::FailureSlots slots;
+                tbb::parallel_for_each(callbacks.begin(), callbacks.end(), [&](const Subscription& cb) {
+                    call<OnError>(cb, stop, slots, args...);
+                });
+                return merge<OnError>(slots);
+            }
+        }
+
         /**
          * @brief Emit an event asynchronously using oneTBB.
          */
         template<typename... Args>
         [[nodiscard]] bool emit_tbb_async(Args... args) {
-            bool success = true;
-            tbb::parallel_for_each(callbacks.begin(), callbacks.end(), [&](const auto& cb) {
-                try {
-                    cb(args...);
-                }
-                catch(...) {
-                    success = false;
-                }
-            });
-            return success;
+            return emit_tbb_async_report(args...).ok();
         }
 #endif
 
 #if defined(__cpp_lib_execution)
+        /**
+         * @brief Emit an event asynchronously using <execution> and report failed subscribers.
+         */
+        template<ErrorPolicy OnError = ErrorPolicy::Continue, typename ExecutionPolicy, typename... Args, typename = std::is_execution_policy<ExecutionPolicy>>
+        EmitReport emit_async_report(ExecutionPolicy policy, Args... args) {
+            if constexpr (nothrow) {
+                std::for_each(policy, callbacks.begin(), callbacks.end(), [&](const auto& cb) {
+                    cb.fn(args...);
+                });
+                return {};
+            }
+            else {
+                std::atomic<bool> stop{false};
+                detail::FailureSlots slots;
+                std::for_each(policy, callbacks.begin(), callbacks.end(), [&](const Subscription& cb) {
+                    call<OnError>(cb, stop, slots, args...);
+                });
+                return merge<OnError>(slots);
+            }
+        }
+
         /**
          * @brief Emit an event asynchronously using <execution>.
          */
         template<typename ExecutionPolicy, typename... Args, typename = std::is_execution_policy<ExecutionPolicy>>
         [[nodiscard]] bool emit_async(ExecutionPolicy policy, Args... args) {
-            bool success = true;
-            std::for_each(policy, callbacks.begin(), callbacks.end(),
-                [&](const auto& cb) {
-                    try {
-                        cb(args...);
-                    }
-                    catch(...) {
-                        success = false;
-                    }
-                }
-            );
-            return success;
+            return emit_async_report(policy, args...).ok();
+        }
+#endif
+
+        /**
+         * @brief Replace the thresholds emit_auto decides with.
+         */
+        void set_dispatch_thresholds(const DispatchThresholds& t) {
+            thresholds = t;
         }
+
+        /**
+         * @brief Dispatch the next emit_auto would use.
+         * @details Sequential until the estimated work of one emit (cost per
+         * callback times fan-out) reaches `thresholds.parallel_work`; then TBB
+         * if a single callback costs at least a grain, otherwise chunks of
+         * about `thresholds.grain` work each.
+         */
+        DispatchPlan dispatch_plan() const {
+            return dispatch_plan(detail::hardware_workers());
+        }
+
+        /**
+         * @brief Dispatch emit_auto would use with the given number of hardware threads.
+         */
+        DispatchPlan dispatch_plan(size_t workers) const {
+            DispatchPlan plan;
+            plan.fanout = callbacks.size();
+            plan.cost = std::chrono::nanoseconds(static_cast<int64_t>(cost_estimate.load(std::memory_order_relaxed)));
+            plan.thresholds = thresholds;
+#if defined(WITH_TBB) || defined(__cpp_lib_execution)
+            auto work = plan.cost * static_cast<int64_t>(plan.fanout);
+            if (workers < 2 || plan.fanout < 2 || work < thresholds.parallel_work) return plan;
+#ifdef WITH_TBB
+            if (plan.cost >= thresholds.grain) {
+                plan.mode = Dispatch::TBB;
+                plan.chunks = parallel_chunks(workers);
+                return plan;
+            }
 #endif
+            auto grain = std::max(thresholds.grain, std::chrono::nanoseconds(1));
+            plan.mode = Dispatch::Chunked;
+            plan.chunks = std::clamp<size_t>(static_cast<size_t>(work / grain), 2, parallel_chunks(workers));
+#else
+            (void)workers;
+#endif
+            return plan;
+        }
+
+        /**
+         * @brief Emit with the dispatch picked by dispatch_plan() and report failed subscribers.
+         * @details Every call measures the time spent in the callbacks and
+         * updates the running cost estimate the next decision is based on.
+         */
+        template<ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args>
+        EmitReport emit_auto_report(Args... args) {
+            DispatchPlan plan = dispatch_plan();
+            std::atomic<bool> stop{false};
+            if (plan.mode == Dispatch::Sequential) {
+                Chunk all;
+                all.first = callbacks.cbegin();
+                all.last = callbacks.cend();
+                run_timed<OnError>(all, stop, args...);
+                observe(std::span(&all, 1), plan.fanout);
+                return merge<OnError>(std::span(&all, 1));
+            }
+            auto chunks = split(plan.chunks);
+            auto body = [&](Chunk& chunk) {
+                run_timed<OnError>(chunk, stop, args...);
+            };
+#ifdef WITH_TBB
+            if (plan.mode == Dispatch::TBB) {
+                tbb::parallel_for_each(chunks.begin(), chunks.end(), body);
+            }
+            else
+#endif
+            {
+#if defined(__cpp_lib_execution)
+                std::for_each(std::execution::par, chunks.begin(), chunks.end(), body);
+#elif defined(WITH_TBB)
+                tbb::parallel_for_each(chunks.begin(), chunks.end(), body);
+#endif
+            }
+            observe(chunks, plan.fanout);
+            return merge<OnError>(chunks);
+        }
+
+        /**
+         * @brief Emit with the dispatch picked from the measured callback cost and fan-out.
+         */
+        template<typename... Args>
+        [[nodiscard]] bool emit_auto(Args... args) {
+            return emit_auto_report(args...).ok();
+        }
     };
 
     /**
      * @brief Central publisher that manages event handlers and distributes events.
      */
     class Publisher {
-        std::unordered_map<size_t, std::unique_ptr<IEventHandler>> events; ///< All registered handlers.
+        using Registry = std::unordered_map<size_t, std::shared_ptr<IEventHandler>>;
+
+        /// All registered handlers; shared so that tokens can release handlers they empty.
+        std::shared_ptr<Registry> events = std::make_shared<Registry>();
+
+        /**
+         * @brief Release the handler of an event if it has no subscriptions left.
+         */
+        static void release_if_empty(Registry& registry, size_t id) {
+            auto it = registry.find(id);
+            if (it != registry.end() && it->second->empty()) {
+                registry.erase(it);
+                if (detail::oversized(registry)) detail::shrink_to_fit(registry);
+            }
+        }
 
         template<auto Event>
-        EventHandler<Event>* get_handler() {
-            auto it = events.find(decltype(Event)::id);
-            if (it == events.end()) {
-                auto handler = std::make_unique<EventHandler<Event>>();
-                auto* raw = handler.get();
-                events[decltype(Event)::id] = std::move(handler);
-                return raw;
+        std::shared_ptr<EventHandler<Event>> get_handler() {
+            auto& handler = (*events)[decltype(Event)::id];
+            if (!handler) {
+                handler = std::make_shared<EventHandler<Event>>();
             }
-            return static_cast<EventHandler<Event>*>(events[decltype(Event)::id].get());
+            return std::static_pointer_cast<EventHandler<Event>>(handler);
+        }
+
+        /**
+         * @brief Existing handler of an event, or nullptr; never creates one.
+         */
+        template<auto Event>
+        EventHandler<Event>* find_handler() const {
+            auto it = events->find(decltype(Event)::id);
+            return it == events->end() ? nullptr : static_cast<EventHandler<Event>*>(it->second.get());
+        }
+
+        /**
+         * @brief Token unsubscribing an object and releasing the handler if that empties it.
+         * @details Does nothing once the handler or the publisher is gone, or once
+         * the object was unsubscribed some other way, even if it subscribed again since.
+         */
+        template<auto Event, typename C>
+        SubscriptionToken make_token(const std::shared_ptr<EventHandler<Event>>& handler, C* obj) const {
+            uint64_t serial = handler->serial_of(obj);
+            std::weak_ptr<EventHandler<Event>> weak = handler;
+            return SubscriptionToken([registry = std::weak_ptr(events), weak, obj, serial]() {
+                auto handler = weak.lock();
+                if (!handler) return;
+                handler->unsubscribe(obj, serial);
+                if (auto live = registry.lock()) release_if_empty(*live, decltype(Event)::id);
+            }, obj, weak, serial);
         }
 
     public:
+        Publisher() = default;
+
+        Publisher(const Publisher&) = delete;
+        Publisher& operator=(const Publisher&) = delete;
+
+        /**
+         * @brief Take over the handlers of another publisher, leaving it empty and usable.
+         */
+        Publisher(Publisher&& other) : events(std::exchange(other.events, std::make_shared<Registry>())) {}
+
+        /**
+         * @brief Replace the handlers with those of another publisher, leaving it empty and usable.
+         */
+        Publisher& operator=(Publisher&& other) {
+            if (this != &other) {
+                events = std::exchange(other.events, std::make_shared<Registry>());
+            }
+            return *this;
+        }
+
         /**
          * @brief Subscribe a free function or lambda.
          */
         template<auto Event> requires IsEvent<decltype(Event)>
-        SubscriptionToken subscribe(std::function<typename decltype(Event)::func_t> f) {
-            auto* handler = get_handler<Event>();
-            handler->subscribe(f);
-            return SubscriptionToken([handler]() {}); // Lambdas not tracked
+        SubscriptionToken subscribe(callback_t<Event> f) {
+            auto* handle = get_handler<Event>()->subscribe(f);
+            return SubscriptionToken({}, handle); // Lambdas not tracked
+        }
+
+        /**
+         * @brief Subscribe a free function or lambda, delivered serially on a strand.
+         */
+        template<auto Event> requires IsEvent<decltype(Event)>
+        SubscriptionToken subscribe(callback_t<Event> f, const Strand& strand) {
+            auto* handle = get_handler<Event>()->subscribe(f, strand);
+            return SubscriptionToken({}, handle); // Lambdas not tracked
         }
 
         /**
          * @brief Subscribe a member function from an object.
+         * @return An empty token if the object was already subscribed.
          */
         template<auto Event, typename C, typename... Args> requires IsEvent<decltype(Event)>
         SubscriptionToken subscribe(C* obj, void (C::* mem_fn)(Args...)) {
-            auto* handler = get_handler<Event>();
-            handler->subscribe(obj, mem_fn);
-            return SubscriptionToken([handler, obj]() {
-                handler->unsubscribe(obj);
-            });
+            auto handler = get_handler<Event>();
+            if (!handler->subscribe(obj, mem_fn)) return SubscriptionToken();
+            return make_token<Event>(handler, obj);
+        }
+
+        /**
+         * @brief Subscribe a member function from an object, delivered serially on a strand.
+         * @return An empty token if the object was already subscribed.
+         */
+        template<auto Event, typename C, typename... Args> requires IsEvent<decltype(Event)>
+        SubscriptionToken subscribe(C* obj, void (C::* mem_fn)(Args...), const Strand& strand) {
+            auto handler = get_handler<Event>();
+            if (!handler->subscribe(obj, mem_fn, strand)) return SubscriptionToken();
+            return make_token<Event>(handler, obj);
         }
 
         /**
@@ -267,7 +1091,17 @@ namespace pubsub {
          */
         template<auto Event, typename... Args> requires IsEvent<decltype(Event)>
         bool emit(Args... args) {
-            return get_handler<Event>()->emit(args...);
+            auto* handler = find_handler<Event>();
+            return handler ? handler->emit(args...) : true;
+        }
+
+        /**
+         * @brief Emit an event synchronously and report which listeners failed.
+         */
+        template<auto Event, ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args> requires IsEvent<decltype(Event)>
+        EmitReport emit_report(Args... args) {
+            auto* handler = find_handler<Event>();
+            return handler ? handler->template emit_report<OnError>(args...) : EmitReport{};
         }
 
         /**
@@ -275,7 +1109,17 @@ namespace pubsub {
          */
         template<auto Event, typename... Args> requires IsEvent<decltype(Event)>
         bool emit_thread_async(Args... args) {
-            return get_handler<Event>()->emit_thread_async(args...);
+            auto* handler = find_handler<Event>();
+            return handler ? handler->emit_thread_async(args...) : true;
+        }
+
+        /**
+         * @brief Emit an event asynchronously and report which listeners failed.
+         */
+        template<auto Event, ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args> requires IsEvent<decltype(Event)>
+        EmitReport emit_thread_async_report(Args... args) {
+            auto* handler = find_handler<Event>();
+            return handler ? handler->template emit_thread_async_report<OnError>(args...) : EmitReport{};
         }
 
 #ifdef WITH_TBB
@@ -284,7 +1128,17 @@ namespace pubsub {
          */
         template<auto Event, typename... Args> requires IsEvent<decltype(Event)>
         bool emit_tbb_async(Args... args) {
-            return get_handler<Event>()->emit_tbb_async(args...);
+            auto* handler = find_handler<Event>();
+            return handler ? handler->emit_tbb_async(args...) : true;
+        }
+
+        /**
+         * @brief Emit an event asynchronously using oneTBB and report which listeners failed.
+         */
+        template<auto Event, ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args> requires IsEvent<decltype(Event)>
+        EmitReport emit_tbb_async_report(Args... args) {
+            auto* handler = find_handler<Event>();
+            return handler ? handler->template emit_tbb_async_report<OnError>(args...) : EmitReport{};
         }
 #else
         #warning TBB not available
@@ -296,22 +1150,106 @@ namespace pubsub {
          */
         template<auto Event, typename... Args> requires IsEvent<decltype(Event)>
         bool emit_async(Args... args) {
-            return get_handler<Event>()->emit_async(args...);
+            auto* handler = find_handler<Event>();
+            return handler ? handler->emit_async(args...) : true;
+        }
+
+        /**
+         * @brief Emit an event asynchronously and report which listeners failed.
+         */
+        template<auto Event, ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args> requires IsEvent<decltype(Event)>
+        EmitReport emit_async_report(Args... args) {
+            auto* handler = find_handler<Event>();
+            return handler ? handler->template emit_async_report<OnError>(args...) : EmitReport{};
         }
 #else
         #warning std::execution not available
 #endif
 
+        /**
+         * @brief Emit an event sequentially or in parallel, whichever the measured cost favours.
+         */
+        template<auto Event, typename... Args> requires IsEvent<decltype(Event)>
+        bool emit_auto(Args... args) {
+            auto* handler = find_handler<Event>();
+            return handler ? handler->emit_auto(args...) : true;
+        }
+
+        /**
+         * @brief Adaptive emit that reports which listeners failed.
+         */
+        template<auto Event, ErrorPolicy OnError = ErrorPolicy::Continue, typename... Args> requires IsEvent<decltype(Event)>
+        EmitReport emit_auto_report(Args... args) {
+            auto* handler = find_handler<Event>();
+            return handler ? handler->template emit_auto_report<OnError>(args...) : EmitReport{};
+        }
+
+        /**
+         * @brief Inspect how the next emit_auto of an event would be dispatched.
+         */
+        template<auto Event> requires IsEvent<decltype(Event)>
+        DispatchPlan dispatch_plan() const {
+            auto* handler = find_handler<Event>();
+            return handler ? handler->dispatch_plan() : DispatchPlan{};
+        }
+
+        /**
+         * @brief Inspect how emit_auto of an event would be dispatched with the given number of hardware threads.
+         */
+        template<auto Event> requires IsEvent<decltype(Event)>
+        DispatchPlan dispatch_plan(size_t workers) const {
+            auto* handler = find_handler<Event>();
+            return handler ? handler->dispatch_plan(workers) : DispatchPlan{};
+        }
+
+        /**
+         * @brief Tune the thresholds emit_auto of an event decides with.
+         */
+        template<auto Event> requires IsEvent<decltype(Event)>
+        void set_dispatch_thresholds(const DispatchThresholds& thresholds) {
+            get_handler<Event>()->set_dispatch_thresholds(thresholds);
+        }
+
         /**
          * @brief Unsubscribe an object from the event.
+         * @details A handler left without subscriptions is released, as it is
+         * when a SubscriptionToken unsubscribes. For strand-bound objects this
+         * first waits for the calls already queued, or skips them when called
+         * from a ThreadPool worker, e.g. from another strand-bound callback.
          */
         template<auto Event, typename C> requires IsEvent<decltype(Event)>
         void unsubscribe(C* obj) {
-            auto it = events.find(decltype(Event)::id);
-            if (it != events.end()) {
-                static_cast<EventHandler<Event>*>(it->second.get())->unsubscribe(obj);
+            if (auto* handler = find_handler<Event>()) {
+                handler->unsubscribe(obj);
+                release_if_empty(*events, decltype(Event)::id);
             }
         }
+
+        /**
+         * @brief Release handlers without subscriptions and shrink the storage of the others.
+         * @details Handlers with custom dispatch thresholds are kept. Must not
+         * run concurrently with an emit.
+         */
+        void compact() {
+            std::erase_if(*events, [](const auto& entry) { return entry.second->empty(); });
+            for (auto& [id, handler] : *events) {
+                handler->compact();
+            }
+            detail::shrink_to_fit(*events);
+        }
+
+        /**
+         * @brief Estimated heap footprint of every live event handler.
+         */
+        MemoryUsage memory_usage() const {
+            MemoryUsage usage;
+            usage.events.reserve(events->size());
+            for (const auto& [id, handler] : *events) {
+                usage.events.push_back(handler->memory_usage());
+            }
+            usage.registry_bytes = detail::hashed_bytes(*events);
+            return usage;
+        }
     };
 
     /**
@@ -319,15 +1257,25 @@ namespace pubsub {
      */
     class Subscriber {
         std::list<Publisher*> publishers; ///< All known publishers.
+        static constexpr size_t min_purge_at = 16; ///< Smallest token count that triggers a purge.
+        size_t purge_at = min_purge_at;           ///< Token count at which store_token purges next.
     protected:
         std::vector<SubscriptionToken> tokens; ///< Stores subscription tokens for RAII unsubscription.
 
         /**
          * @brief Internally track a token.
+         * @details Once the list reaches a threshold, tokens whose subscription
+         * is already gone are dropped and the threshold is set to twice what is
+         * left, so resubscribing repeatedly does not grow the list and storing
+         * stays amortised constant time.
          */
         template<typename Token>
         void store_token(Token&& t) {
-            tokens.emplace_back(std::forward<Token>(t));
+            if (tokens.size() >= purge_at) {
+                std::erase_if(tokens, [](const SubscriptionToken& token) { return !token.active(); });
+                purge_at = std::max(min_purge_at, 2 * tokens.size());
+            }
+            if (t) tokens.emplace_back(std::forward<Token>(t));
         }
 
     public:
@@ -340,7 +1288,9 @@ namespace pubsub {
          * @brief Tracks a publisher.
          */
         virtual void subscribe_to(Publisher& p) {
-            publishers.push_back(&p);
+            if (std::find(publishers.begin(), publishers.end(), &p) == publishers.end()) {
+                publishers.push_back(&p);
+            }
         }
 
         /**
@@ -357,6 +1307,8 @@ namespace pubsub {
             }
             publishers.clear();
             tokens.clear();
+            tokens.shrink_to_fit();
+            purge_at = min_purge_at;
         }
     };
 
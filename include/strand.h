@@ -0,0 +1,407 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <exception>
+
+/**
+ * @file strand.h
+ * @brief Shared worker pool and strands that serialize work posted to them.
+ */
+
+namespace pubsub {
+
+    /**
+     * @brief Fixed-size pool of worker threads consuming a shared task queue.
+     */
+    class ThreadPool {
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopping = false;
+
+        static bool& is_worker() {
+            thread_local bool worker = false;
+            return worker;
+        }
+
+        void work() {
+            is_worker() = true;
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(mutex);
+                    cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                    if (tasks.empty()) return;
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        /**
+         * @brief Start the workers.
+         * @param threads Number of worker threads, defaults to the hardware concurrency.
+         */
+        explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+            workers.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                workers.emplace_back([this] { work(); });
+            }
+        }
+
+        /**
+         * @brief Finishes all queued tasks and joins the workers.
+         */
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            cv.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Queue a task for execution on any worker.
+         */
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard lock(mutex);
+                tasks.push_back(std::move(task));
+            }
+            cv.notify_one();
+        }
+
+        /**
+         * @brief Number of worker threads.
+         */
+        size_t size() const {
+            return workers.size();
+        }
+
+        /**
+         * @brief Whether the calling thread is a worker of any pool.
+         */
+        static bool in_worker_thread() {
+            return is_worker();
+        }
+
+        /**
+         * @brief Process-wide pool used by default-constructed strands.
+         */
+        static ThreadPool& shared() {
+            static ThreadPool pool;
+            return pool;
+        }
+    };
+
+    /**
+     * @brief Receives exceptions thrown by tasks running on a strand.
+     */
+    using StrandErrorHandler = std::function<void(std::exception_ptr)>;
+
+    namespace detail {
+
+        /**
+         * @brief Lock-free multi-producer single-consumer queue (intrusive Vyukov design).
+         */
+        template<typename T>
+        class MpscQueue {
+            struct Node {
+                std::atomic<Node*> next{nullptr};
+                T value;
+            };
+
+            std::atomic<Node*> head; ///< Last pushed node, shared by producers.
+            Node* tail;              ///< Stub node owned by the consumer.
+
+        public:
+            MpscQueue() : head(new Node{}), tail(head.load(std::memory_order_relaxed)) {}
+
+            ~MpscQueue() {
+                while (tail) {
+                    Node* next = tail->next.load(std::memory_order_relaxed);
+                    delete tail;
+                    tail = next;
+                }
+            }
+
+            MpscQueue(const MpscQueue&) = delete;
+            MpscQueue& operator=(const MpscQueue&) = delete;
+
+            /**
+             * @brief Append a value, safe to call from any number of threads.
+             */
+            void push(T value) {
+                Node* node = new Node{};
+                node->value = std::move(value);
+                Node* prev = head.exchange(node, std::memory_order_acq_rel);
+                prev->next.store(node, std::memory_order_release);
+            }
+
+            /**
+             * @brief Take the oldest value, only to be called by the single consumer.
+             * @return False if the queue is empty or the next push is not linked yet.
+             */
+            bool pop(T& out) {
+                Node* next = tail->next.load(std::memory_order_acquire);
+                if (!next) return false;
+                out = std::move(next->value);
+                delete tail;
+                tail = next;
+                return true;
+            }
+        };
+
+        /**
+         * @brief Shared state of a strand: its queue and the number of unfinished tasks.
+         */
+        class StrandState : public std::enable_shared_from_this<StrandState> {
+            static constexpr size_t batch_size = 64; ///< Tasks run before yielding the worker to other strands.
+
+            ThreadPool& pool;
+            MpscQueue<std::function<void()>> queue;
+            std::atomic<size_t> pending{0};
+            StrandErrorHandler on_error;     ///< Set once at construction, read by the running task only.
+            std::mutex error_mutex;
+            std::exception_ptr unhandled;    ///< First failure when there is no error handler.
+
+            static const StrandState*& current() {
+                thread_local const StrandState* running = nullptr;
+                return running;
+            }
+
+            void schedule() {
+                pool.submit([self = shared_from_this()] { self->run(); });
+            }
+
+            void run() {
+                current() = this;
+                for (size_t executed = 1;; ++executed) {
+                    std::function<void()> task;
+                    while (!queue.pop(task)) {
+                        std::this_thread::yield(); // A producer is between its exchange and its link.
+                    }
+                    try {
+                        task();
+                    }
+                    catch(...) {
+                        fail(std::current_exception());
+                    }
+                    task = nullptr;
+                    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) break;
+                    if (executed == batch_size) {
+                        current() = nullptr;
+                        schedule();
+                        return;
+                    }
+                }
+                current() = nullptr;
+            }
+
+            void fail(std::exception_ptr error) {
+                if (on_error) {
+                    on_error(std::move(error));
+                    return;
+                }
+                std::lock_guard lock(error_mutex);
+                if (!unhandled) unhandled = std::move(error);
+            }
+
+        public:
+            StrandState(ThreadPool& p, StrandErrorHandler handler) : pool(p), on_error(std::move(handler)) {}
+
+            std::exception_ptr take_error() {
+                std::lock_guard lock(error_mutex);
+                return std::exchange(unhandled, nullptr);
+            }
+
+            void post(std::function<void()> task) {
+                queue.push(std::move(task));
+                if (pending.fetch_add(1, std::memory_order_acq_rel) == 0) {
+                    schedule();
+                }
+            }
+
+            void drain() {
+                if (running_in_this_thread()) return;
+                if (pending.load(std::memory_order_acquire) == 0) return;
+                // Tasks run in posting order: once the marker has run, so has everything before it.
+                auto done = std::make_shared<std::atomic<bool>>(false);
+                post([done] {
+                    done->store(true, std::memory_order_release);
+                    done->notify_all();
+                });
+                done->wait(false, std::memory_order_acquire);
+            }
+
+            bool running_in_this_thread() const {
+                return current() == this;
+            }
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Serial execution context on top of a ThreadPool.
+     *
+     * Tasks posted to the same strand run one at a time and in posting order;
+     * different strands run in parallel on the pool's workers. Copies of a
+     * strand refer to the same queue.
+     *
+     * A task that throws does not stop the strand: its exception goes to the
+     * error handler given at construction, or, without one, the first such
+     * exception is kept until take_error() collects it.
+     *
+     * Emits only enqueue the calls of subscriptions bound to a strand, so the
+     * subscriber sees its events one at a time and in emit order, and the
+     * failures of those calls are reported here, never in an EmitReport.
+     */
+    class Strand {
+        std::shared_ptr<detail::StrandState> state;
+
+    public:
+        /**
+         * @brief Create a strand executing on the given pool.
+         * @param on_error Called on the strand with the exception of every task that throws;
+         * it must not throw itself.
+         */
+        explicit Strand(ThreadPool& pool = ThreadPool::shared(), StrandErrorHandler on_error = {})
+            : state(std::make_shared<detail::StrandState>(pool, std::move(on_error))) {}
+
+        /**
+         * @brief Take the first exception thrown by a task since the last call, if any.
+         * @note Always empty for strands created with an error handler.
+         */
+        std::exception_ptr take_error() const {
+            return state->take_error();
+        }
+
+        /**
+         * @brief Queue a task behind everything already posted to this strand.
+         */
+        void post(std::function<void()> task) const {
+            state->post(std::move(task));
+        }
+
+        /**
+         * @brief Block until every task posted so far has finished.
+         * @details Tasks posted after the call are not waited for, and the
+         * calling thread sleeps instead of spinning.
+         * @note Returns immediately when called from a task of this strand.
+         * Calling it from a task of another strand of a single-threaded pool deadlocks.
+         */
+        void drain() const {
+            state->drain();
+        }
+
+        /**
+         * @brief Whether the calling thread is currently executing a task of this strand.
+         */
+        bool running_in_this_thread() const {
+            return state->running_in_this_thread();
+        }
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Lets a subscription be cut off from the calls queued for it on a strand.
+         */
+        class StrandGate {
+            std::atomic<bool> open{true};
+            std::atomic<size_t> running{0}; ///< Calls between entering and leaving the gate.
+
+        public:
+            /**
+             * @brief Run a call unless the gate has been closed.
+             */
+            template<typename F>
+            void pass(F&& f) {
+                struct Leave {
+                    std::atomic<size_t>& running;
+                    ~Leave() {
+                        if (running.fetch_sub(1) == 1) running.notify_all();
+                    }
+                };
+                running.fetch_add(1);
+                Leave leave{running};
+                if (open.load()) f();
+            }
+
+            /**
+             * @brief Skip every call that has not started yet.
+             * @param wait Also wait for a call that is running right now.
+             */
+            void close(bool wait) {
+                open.store(false);
+                if (!wait) return;
+                for (size_t n = running.load(); n != 0; n = running.load()) {
+                    running.wait(n);
+                }
+            }
+        };
+
+        /**
+         * @brief Strand of a strand-bound member subscription and the gate its calls pass.
+         */
+        struct StrandBinding {
+            Strand strand;
+            std::shared_ptr<StrandGate> gate = std::make_shared<StrandGate>();
+
+            /**
+             * @brief Stop the subscription's calls; afterwards none runs or is running.
+             * @details Off the pool, the calls already queued run first. On a pool
+             * worker they are skipped instead, and only a call running on another
+             * worker is waited for, so a worker never waits for pool capacity.
+             */
+            void release() const {
+                if (strand.running_in_this_thread()) {
+                    gate->close(false);
+                    return;
+                }
+                if (!ThreadPool::in_worker_thread()) strand.drain();
+                gate->close(true);
+            }
+        };
+
+        template<typename HandlerT>
+        struct strand_binder;
+
+        /**
+         * @brief Wraps a callback so that invoking it posts the call to a strand.
+         */
+        template<typename... Params>
+        struct strand_binder<void(Params...)> {
+            static std::function<void(Params...)> bind(std::function<void(Params...)> f, Strand strand,
+                                                       std::shared_ptr<StrandGate> gate = nullptr) {
+                auto target = std::make_shared<const std::function<void(Params...)>>(std::move(f));
+                return [target = std::move(target), strand = std::move(strand), gate = std::move(gate)](Params... params) {
+                    strand.post([target, gate, ...params = std::decay_t<Params>(params)]() mutable {
+                        if (gate) gate->pass([&] { (*target)(params...); });
+                        else (*target)(params...);
+                    });
+                };
+            }
+        };
+
+    } // namespace detail
+
+} // namespace pubsub
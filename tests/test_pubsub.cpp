@@ -1,6 +1,7 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_all.hpp>
 #include "pubsub.h"
+#include <optional>
 
 using namespace pubsub;
 
@@ -161,3 +162,550 @@ TEST_CASE("Multiple subscribers are cleaned up without memory leaks") {
     pub.emit<TestEvents::Ping>();
     REQUIRE(total_calls == 2);
 }
+
+TEST_CASE("Strand-bound subscriber receives events serially and in emit order") {
+    Publisher pub;
+    Strand strand;
+
+    class OrderedSub : public Subscriber {
+    public:
+        std::vector<int> received;
+        std::atomic<int> in_flight{0};
+        bool overlapped = false;
+        Strand strand;
+        OrderedSub(Strand s) : strand(std::move(s)) {}
+        ~OrderedSub() override { unsubscribe_from_all(); }
+
+        void subscribe_to(Publisher& p) override {
+            store_token(p.subscribe<TestEvents::Data>(this, &OrderedSub::on_data, strand));
+            Subscriber::subscribe_to(p);
+        }
+
+        void unsubscribe_from(Publisher& p) override {
+            p.unsubscribe<TestEvents::Data>(this);
+        }
+
+        void on_data(int val) {
+            if (in_flight.fetch_add(1) != 0) overlapped = true;
+            received.push_back(val);
+            in_flight.fetch_sub(1);
+        }
+    } sub(strand);
+
+    sub.subscribe_to(pub);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(pub.emit<TestEvents::Data>(i));
+    }
+    strand.drain();
+
+    REQUIRE_FALSE(sub.overlapped);
+    REQUIRE(sub.received.size() == 1000);
+    REQUIRE(std::is_sorted(sub.received.begin(), sub.received.end()));
+}
+
+TEST_CASE("Different strands run in parallel on a shared pool") {
+    ThreadPool pool(2);
+    Strand first(pool), second(pool);
+    Publisher pub;
+    std::atomic<int> started{0};
+    std::atomic<bool> overlapped{false};
+
+    auto rendezvous = [&] {
+        started.fetch_add(1);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (started.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        if (started.load() == 2) overlapped = true;
+    };
+    pub.subscribe<TestEvents::Ping>(rendezvous, first);
+    pub.subscribe<TestEvents::Ping>(rendezvous, second);
+
+    REQUIRE(pub.emit<TestEvents::Ping>());
+    first.drain();
+    second.drain();
+    REQUIRE(overlapped);
+}
+
+TEST_CASE("Unsubscribing a strand-bound subscriber waits for queued events") {
+    Publisher pub;
+    Strand strand;
+    int call_count = 0;
+
+    {
+        class SlowSub : public Subscriber {
+        public:
+            int& ref;
+            Strand strand;
+            SlowSub(int& count, Strand s) : ref(count), strand(std::move(s)) {}
+            ~SlowSub() override { unsubscribe_from_all(); }
+
+            void subscribe_to(Publisher& p) override {
+                store_token(p.subscribe<TestEvents::Ping>(this, &SlowSub::on_ping, strand));
+                Subscriber::subscribe_to(p);
+            }
+
+            void unsubscribe_from(Publisher& p) override {
+                p.unsubscribe<TestEvents::Ping>(this);
+            }
+
+            void on_ping() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ref++;
+            }
+        } sub(call_count, strand);
+
+        sub.subscribe_to(pub);
+        for (int i = 0; i < 20; ++i) {
+            REQUIRE(pub.emit<TestEvents::Ping>());
+        }
+    }
+
+    REQUIRE(call_count == 20);
+    pub.emit<TestEvents::Ping>();
+    strand.drain();
+    REQUIRE(call_count == 20);
+}
+
+struct ErrorEvents {
+    static constexpr auto Fail = Event<void(int)>();
+    static constexpr auto Quiet = Event<void(int) noexcept>();
+};
+
+class FailingSubscriber : public Subscriber {
+public:
+    ~FailingSubscriber() override { unsubscribe_from_all(); }
+
+    std::atomic<int> calls{0};
+
+    void on_fail(int val) {
+        calls++;
+        if (val < 0) throw std::runtime_error("negative");
+    }
+
+    void subscribe_to(Publisher& p) override {
+        store_token(p.subscribe<ErrorEvents::Fail>(this, &FailingSubscriber::on_fail));
+        Subscriber::subscribe_to(p);
+    }
+
+    void unsubscribe_from(Publisher& p) override {
+        p.unsubscribe<ErrorEvents::Fail>(this);
+    }
+};
+
+TEST_CASE("Emit report names the failed subscribers and keeps the first exception") {
+    Publisher pub;
+    FailingSubscriber sub;
+    int lambda_calls = 0;
+
+    pub.subscribe<ErrorEvents::Fail>([&](int) { lambda_calls++; });
+    sub.subscribe_to(pub);
+
+    auto report = pub.emit_report<ErrorEvents::Fail>(-1);
+    REQUIRE_FALSE(report.ok());
+    REQUIRE(report.failed.size() == 1);
+    REQUIRE(report.failed.front() == &sub);
+    REQUIRE_THROWS_AS(std::rethrow_exception(report.first_error), std::runtime_error);
+    REQUIRE(lambda_calls == 1);
+
+    REQUIRE(pub.emit_report<ErrorEvents::Fail>(1).ok());
+    REQUIRE_FALSE(pub.emit<ErrorEvents::Fail>(-1));
+}
+
+TEST_CASE("Failed lambdas are reported under the handle of their token") {
+    Publisher pub;
+    auto quiet = pub.subscribe<ErrorEvents::Fail>([](int) {});
+    auto loud = pub.subscribe<ErrorEvents::Fail>([](int) { throw std::runtime_error("loud"); });
+    REQUIRE(quiet.handle() != loud.handle());
+
+    auto report = pub.emit_report<ErrorEvents::Fail>(0);
+    REQUIRE(report.failed.size() == 1);
+    REQUIRE(report.failed.front() == loud.handle());
+}
+
+TEST_CASE("Error policies stop or rethrow after the first failure") {
+    Publisher pub;
+    int later_calls = 0;
+
+    pub.subscribe<ErrorEvents::Fail>([](int) { throw std::logic_error("first"); });
+    pub.subscribe<ErrorEvents::Fail>([&](int) { later_calls++; });
+
+    REQUIRE(pub.emit_report<ErrorEvents::Fail, ErrorPolicy::Continue>(0).failed.size() == 1);
+    REQUIRE(later_calls == 1);
+
+    REQUIRE(pub.emit_report<ErrorEvents::Fail, ErrorPolicy::Stop>(0).failed.size() == 1);
+    REQUIRE(later_calls == 1);
+
+    REQUIRE_THROWS_AS((pub.emit_report<ErrorEvents::Fail, ErrorPolicy::Rethrow>(0)), std::logic_error);
+    REQUIRE(later_calls == 1);
+}
+
+TEST_CASE("Parallel emits report every failure exactly once") {
+    Publisher pub;
+    std::vector<std::unique_ptr<FailingSubscriber>> subs;
+    for (int i = 0; i < 100; ++i) {
+        subs.push_back(std::make_unique<FailingSubscriber>());
+        subs.back()->subscribe_to(pub);
+    }
+
+    auto check = [&](const EmitReport& report) {
+        REQUIRE(report.failed.size() == subs.size());
+        for (size_t i = 0; i < subs.size(); ++i) {
+            REQUIRE(report.failed[i] == subs[i].get());
+        }
+        REQUIRE(report.first_error);
+    };
+
+    check(pub.emit_thread_async_report<ErrorEvents::Fail>(-1));
+#ifdef WITH_TBB
+    check(pub.emit_tbb_async_report<ErrorEvents::Fail>(-1));
+    REQUIRE_FALSE(pub.emit_tbb_async<ErrorEvents::Fail>(-1));
+#endif
+#if defined(__cpp_lib_execution)
+    check(pub.emit_async_report<ErrorEvents::Fail>(std::execution::par, -1));
+    REQUIRE_FALSE(pub.emit_async<ErrorEvents::Fail>(std::execution::par, -1));
+    REQUIRE(pub.emit_async<ErrorEvents::Fail>(std::execution::par, 1));
+#endif
+}
+
+TEST_CASE("Noexcept events are delivered without error tracking") {
+    Publisher pub;
+    int sum = 0;
+
+    pub.subscribe<ErrorEvents::Quiet>([&](int val) { sum += val; });
+    REQUIRE(pub.emit<ErrorEvents::Quiet>(3));
+    REQUIRE(pub.emit_report<ErrorEvents::Quiet>(4).ok());
+    REQUIRE(sum == 7);
+}
+
+TEST_CASE("Adaptive emit stays sequential for cheap callbacks and learns their cost") {
+    Publisher pub;
+    int calls = 0;
+    for (int i = 0; i < 4; ++i) {
+        pub.subscribe<TestEvents::Data>([&](int) { calls++; });
+    }
+
+    REQUIRE(pub.dispatch_plan<TestEvents::Data>().cost.count() == 0);
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(pub.emit_auto<TestEvents::Data>(i));
+    }
+
+    auto plan = pub.dispatch_plan<TestEvents::Data>();
+    REQUIRE(calls == 40);
+    REQUIRE(plan.fanout == 4);
+    REQUIRE(plan.mode == Dispatch::Sequential);
+    REQUIRE(plan.chunks == 1);
+}
+
+TEST_CASE("Adaptive emit follows the configured thresholds") {
+    Publisher pub;
+    std::atomic<int> calls{0};
+    for (int i = 0; i < 64; ++i) {
+        pub.subscribe<TestEvents::Data>([&](int) { calls++; });
+    }
+    bool parallel_hardware = std::thread::hardware_concurrency() >= 2;
+
+    pub.set_dispatch_thresholds<TestEvents::Data>({std::chrono::nanoseconds(0), std::chrono::hours(1)});
+    auto plan = pub.dispatch_plan<TestEvents::Data>();
+    REQUIRE(plan.thresholds.grain == std::chrono::hours(1));
+    if (parallel_hardware) {
+        REQUIRE(plan.mode == Dispatch::Chunked);
+        REQUIRE(plan.chunks >= 2);
+        REQUIRE(plan.chunks <= plan.fanout);
+    }
+    REQUIRE(pub.emit_auto<TestEvents::Data>(1));
+    REQUIRE(calls == 64);
+
+#ifdef WITH_TBB
+    pub.set_dispatch_thresholds<TestEvents::Data>({std::chrono::nanoseconds(0), std::chrono::nanoseconds(0)});
+    if (parallel_hardware) {
+        REQUIRE(pub.dispatch_plan<TestEvents::Data>().mode == Dispatch::TBB);
+    }
+    REQUIRE(pub.emit_auto<TestEvents::Data>(1));
+    REQUIRE(calls == 128);
+#endif
+
+    pub.set_dispatch_thresholds<TestEvents::Data>({std::chrono::hours(1), std::chrono::nanoseconds(0)});
+    REQUIRE(pub.dispatch_plan<TestEvents::Data>().mode == Dispatch::Sequential);
+}
+
+TEST_CASE("Adaptive emit picks parallel dispatch only for heavy fan-outs") {
+    Publisher pub;
+    for (int i = 0; i < 4; ++i) {
+        pub.subscribe<TestEvents::Ping>([] {});
+        pub.subscribe<TestEvents::Data>([](int) { std::this_thread::sleep_for(std::chrono::microseconds(200)); });
+    }
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(pub.emit_auto<TestEvents::Ping>());
+        REQUIRE(pub.emit_auto<TestEvents::Data>(i));
+    }
+
+    REQUIRE(pub.dispatch_plan<TestEvents::Ping>(8).mode == Dispatch::Sequential);
+    REQUIRE(pub.dispatch_plan<TestEvents::Data>(1).mode == Dispatch::Sequential);
+
+    auto heavy = pub.dispatch_plan<TestEvents::Data>(8);
+    REQUIRE(heavy.cost >= std::chrono::microseconds(200));
+#ifdef WITH_TBB
+    REQUIRE(heavy.mode == Dispatch::TBB);
+    REQUIRE(heavy.chunks == heavy.fanout);
+#elif defined(__cpp_lib_execution)
+    REQUIRE(heavy.mode == Dispatch::Chunked);
+    REQUIRE(heavy.chunks == heavy.fanout);
+#endif
+}
+
+TEST_CASE("Adaptive emit reports failures from parallel chunks") {
+    Publisher pub;
+    std::vector<std::unique_ptr<FailingSubscriber>> subs;
+    for (int i = 0; i < 16; ++i) {
+        subs.push_back(std::make_unique<FailingSubscriber>());
+        subs.back()->subscribe_to(pub);
+    }
+    pub.set_dispatch_thresholds<ErrorEvents::Fail>({std::chrono::nanoseconds(0), std::chrono::hours(1)});
+
+    auto report = pub.emit_auto_report<ErrorEvents::Fail>(-1);
+    REQUIRE(report.failed.size() == subs.size());
+    REQUIRE(report.failed.front() == subs.front().get());
+    REQUIRE_THROWS_AS((pub.emit_auto_report<ErrorEvents::Fail, ErrorPolicy::Rethrow>(-1)), std::runtime_error);
+}
+
+TEST_CASE("Emitting to an event without subscribers allocates no handler") {
+    Publisher pub;
+    REQUIRE(pub.emit<TestEvents::Ping>());
+    REQUIRE(pub.emit_report<TestEvents::Data>(1).ok());
+    REQUIRE(pub.memory_usage().events.empty());
+}
+
+TEST_CASE("Memory usage is reported per event") {
+    Publisher pub;
+    TestSubscriber sub;
+    sub.subscribe_to(pub);
+    pub.subscribe<TestEvents::Data>([](int) {});
+
+    auto usage = pub.memory_usage();
+    REQUIRE(usage.events.size() == 2);
+    for (const auto& event : usage.events) {
+        REQUIRE(event.subscribers == (event.id == decltype(TestEvents::Data)::id ? 2u : 1u));
+        REQUIRE(event.callback_bytes > 0);
+        REQUIRE(event.index_bytes > 0);
+    }
+    REQUIRE(usage.total() > usage.registry_bytes);
+}
+
+TEST_CASE("Unsubscribing the last subscriber releases the event handler") {
+    Publisher pub;
+    {
+        TestSubscriber sub;
+        sub.subscribe_to(pub);
+        REQUIRE(pub.memory_usage().events.size() == 2);
+    }
+    REQUIRE(pub.memory_usage().events.empty());
+
+    TestSubscriber again;
+    again.subscribe_to(pub);
+    pub.emit<TestEvents::Ping>();
+    REQUIRE(again.ping_count == 1);
+}
+
+TEST_CASE("Compaction shrinks indexes after mass unsubscribe and keeps live subscribers") {
+    Publisher pub;
+    TestSubscriber keeper;
+    keeper.subscribe_to(pub);
+
+    auto index_bytes = [&] {
+        size_t bytes = 0;
+        for (const auto& event : pub.memory_usage().events) bytes += event.index_bytes;
+        return bytes;
+    };
+
+    size_t before = index_bytes();
+    {
+        std::vector<std::unique_ptr<TestSubscriber>> crowd;
+        for (int i = 0; i < 1000; ++i) {
+            crowd.push_back(std::make_unique<TestSubscriber>());
+            crowd.back()->subscribe_to(pub);
+        }
+        REQUIRE(index_bytes() > before);
+    }
+    pub.compact();
+    REQUIRE(index_bytes() <= 2 * before);
+
+    pub.set_dispatch_thresholds<TestEvents::Data>({});
+    pub.set_dispatch_thresholds<TestEvents::Ping>({std::chrono::nanoseconds(1), std::chrono::nanoseconds(1)});
+    keeper.unsubscribe_from_all();
+    pub.compact();
+    auto usage = pub.memory_usage();
+    REQUIRE(usage.events.size() == 1);
+    REQUIRE(usage.events.front().id == decltype(TestEvents::Ping)::id);
+}
+
+TEST_CASE("Tokens outliving their released handler are harmless") {
+    Publisher pub;
+    TestSubscriber sub;
+    auto token = pub.subscribe<TestEvents::Ping>(&sub, &TestSubscriber::handlePing);
+    REQUIRE(token);
+    REQUIRE_FALSE(pub.subscribe<TestEvents::Ping>(&sub, &TestSubscriber::handlePing));
+
+    pub.unsubscribe<TestEvents::Ping>(&sub);
+    REQUIRE(pub.memory_usage().events.empty());
+    REQUIRE_NOTHROW(token = SubscriptionToken());
+}
+
+TEST_CASE("Destroying the publisher waits for queued strand-bound events") {
+    struct SlowListener {
+        std::atomic<int> calls{0};
+        void on_ping() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            calls++;
+        }
+    };
+
+    Strand strand;
+    auto listener = std::make_unique<SlowListener>();
+    SubscriptionToken token;
+    {
+        Publisher pub;
+        token = pub.subscribe<TestEvents::Ping>(listener.get(), &SlowListener::on_ping, strand);
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(pub.emit<TestEvents::Ping>());
+        }
+    }
+    REQUIRE(listener->calls == 10);
+    token = SubscriptionToken();
+    listener.reset();
+    strand.drain();
+}
+
+TEST_CASE("Failures of strand-bound callbacks are reported through the strand") {
+    Publisher pub;
+    Strand silent;
+    std::atomic<int> handled{0};
+    Strand hooked(ThreadPool::shared(), [&](std::exception_ptr error) {
+        if (error) handled++;
+    });
+
+    pub.subscribe<ErrorEvents::Fail>([](int val) { if (val < 0) throw std::runtime_error("negative"); }, silent);
+    pub.subscribe<ErrorEvents::Fail>([](int val) { if (val < 0) throw std::runtime_error("negative"); }, hooked);
+
+    REQUIRE(pub.emit_report<ErrorEvents::Fail>(-1).ok());
+    REQUIRE(pub.emit_report<ErrorEvents::Fail>(-2).ok());
+    silent.drain();
+    hooked.drain();
+
+    REQUIRE(handled == 2);
+    REQUIRE(hooked.take_error() == nullptr);
+    auto error = silent.take_error();
+    REQUIRE(error);
+    REQUIRE_THROWS_AS(std::rethrow_exception(error), std::runtime_error);
+    REQUIRE(silent.take_error() == nullptr);
+}
+
+TEST_CASE("Draining a strand does not wait for events posted afterwards") {
+    Strand strand;
+    std::atomic<bool> keep_posting{true};
+    std::atomic<int> executed{0};
+
+    std::thread producer([&] {
+        while (keep_posting) {
+            strand.post([&] { executed++; });
+            std::this_thread::yield();
+        }
+    });
+    while (executed == 0) std::this_thread::yield();
+
+    strand.drain(); // the strand never becomes idle while the producer runs
+    keep_posting = false;
+    producer.join();
+    strand.drain();
+    REQUIRE(executed > 0);
+}
+
+TEST_CASE("Destroying the last token releases the event handler") {
+    Publisher pub;
+    TestSubscriber sub;
+    {
+        auto token = pub.subscribe<TestEvents::Ping>(&sub, &TestSubscriber::handlePing);
+        REQUIRE(pub.memory_usage().events.size() == 1);
+    }
+    REQUIRE(pub.memory_usage().events.empty());
+}
+
+TEST_CASE("Resubscribing does not accumulate stale tokens") {
+    struct CountingSubscriber : TestSubscriber {
+        size_t stored() const { return tokens.size(); }
+    };
+
+    Publisher pub;
+    CountingSubscriber sub;
+    for (int i = 0; i < 1000; ++i) {
+        sub.subscribe_to(pub);
+        sub.unsubscribe_from(pub);
+    }
+    REQUIRE(sub.stored() <= 16);
+
+    sub.subscribe_to(pub);
+    REQUIRE(pub.emit<TestEvents::Ping>());
+    REQUIRE(sub.ping_count == 1);
+}
+
+TEST_CASE("A stale token does not remove a newer subscription") {
+    Publisher pub;
+    TestSubscriber sub;
+    auto old_token = pub.subscribe<TestEvents::Ping>(&sub, &TestSubscriber::handlePing);
+    pub.unsubscribe<TestEvents::Ping>(&sub);
+    REQUIRE_FALSE(old_token.active());
+
+    auto token = pub.subscribe<TestEvents::Ping>(&sub, &TestSubscriber::handlePing);
+    REQUIRE(token.active());
+    old_token = SubscriptionToken();
+    REQUIRE(pub.emit<TestEvents::Ping>());
+    REQUIRE(sub.ping_count == 1);
+}
+
+TEST_CASE("Publishers move but do not copy") {
+    STATIC_REQUIRE_FALSE(std::is_copy_constructible_v<Publisher>);
+    STATIC_REQUIRE_FALSE(std::is_copy_assignable_v<Publisher>);
+    STATIC_REQUIRE(std::is_move_constructible_v<Publisher>);
+    STATIC_REQUIRE(std::is_move_assignable_v<Publisher>);
+
+    Publisher source;
+    TestSubscriber sub;
+    std::optional<Publisher> target;
+    {
+        auto token = source.subscribe<TestEvents::Ping>(&sub, &TestSubscriber::handlePing);
+
+        target.emplace(std::move(source));
+        REQUIRE(target->emit<TestEvents::Ping>());
+        REQUIRE(sub.ping_count == 1);
+
+        REQUIRE(source.emit<TestEvents::Ping>());
+        REQUIRE(sub.ping_count == 1);
+        REQUIRE(source.memory_usage().events.empty());
+    }
+    REQUIRE(target->memory_usage().events.empty());
+}
+
+TEST_CASE("Unsubscribing from a pool worker skips queued events instead of blocking") {
+    struct Listener {
+        std::atomic<int> calls{0};
+        void on_data(int) { calls++; }
+    };
+
+    ThreadPool pool(1);
+    Strand first(pool), second(pool);
+    Publisher pub;
+    Listener listener;
+    auto token = pub.subscribe<TestEvents::Data>(&listener, &Listener::on_data, second);
+    pub.subscribe<TestEvents::Ping>([&] { pub.unsubscribe<TestEvents::Data>(&listener); }, first);
+
+    std::promise<void> queued;
+    pool.submit([ready = queued.get_future().share()] { ready.wait(); }); // hold the only worker
+    REQUIRE(pub.emit<TestEvents::Ping>());
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(pub.emit<TestEvents::Data>(i));
+    }
+    queued.set_value();
+    first.drain();
+    second.drain();
+    REQUIRE(listener.calls == 0);
+}